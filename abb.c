@@ -5,6 +5,71 @@
 #define EXITO 0
 #define FRACASO -1
 #define INTERRUPCION -2
+#define PILA_CAPACIDAD_LOCAL 64
+
+/*
+ * Pila de punteros usada por todos los recorridos del arbol en lugar de la recursion.
+ * Los primeros PILA_CAPACIDAD_LOCAL elementos viven dentro de la propia estructura
+ * (alcanza para cualquier arbol AVL razonable sin pedir memoria). Si el arbol es mas
+ * alto, la pila se muda a memoria dinamica y crece al doble cada vez que se llena.
+ * La pila no debe copiarse una vez iniciada.
+ */
+typedef struct pila_nodos {
+    void** elementos;
+    size_t tope;
+    size_t capacidad;
+    void* locales[PILA_CAPACIDAD_LOCAL];
+} pila_nodos_t;
+
+struct abb_iterador {
+    int recorrido;
+    pila_nodos_t pila;
+};
+
+static void pila_iniciar(pila_nodos_t* pila)
+{
+    pila->elementos = pila->locales;
+    pila->tope = 0;
+    pila->capacidad = PILA_CAPACIDAD_LOCAL;
+}
+/*
+ * Apila un puntero. Devuelve false si la pila necesitaba crecer y no pudo.
+ */
+static bool pila_apilar(pila_nodos_t* pila, void* elemento)
+{
+    if(pila->tope == pila->capacidad)
+    {
+        size_t capacidad = pila->capacidad * 2;
+        void** elementos;
+        if(pila->elementos == pila->locales)
+        {
+            elementos = malloc(capacidad * sizeof(void*));
+            if(elementos)
+                for(size_t i = 0; i < pila->tope; i++) elementos[i] = pila->locales[i];
+        }
+        else elementos = realloc(pila->elementos, capacidad * sizeof(void*));
+        if(!elementos) return false;
+        pila->elementos = elementos;
+        pila->capacidad = capacidad;
+    }
+    pila->elementos[pila->tope++] = elemento;
+    return true;
+}
+static void* pila_desapilar(pila_nodos_t* pila)
+{
+    if(pila->tope == 0) return NULL;
+    return pila->elementos[--pila->tope];
+}
+static void* pila_tope(pila_nodos_t* pila)
+{
+    if(pila->tope == 0) return NULL;
+    return pila->elementos[pila->tope - 1];
+}
+static void pila_liberar(pila_nodos_t* pila)
+{
+    if(pila->elementos != pila->locales) free(pila->elementos);
+    pila_iniciar(pila);
+}
 /* 
  * Recibe una funcion comparador que puede comparar los elementos,
  * y funcion destructor para liberar la memoria del elemento al ser destruido.
@@ -14,17 +79,28 @@
  * 
  */
 abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor)
+{
+    return arbol_crear_con_modo(comparador, destructor, ABB_MODO_SIMPLE);
+}
+/* 
+ * Igual que arbol_crear, pero guarda el modo recibido (simple o AVL).
+ * Si recibe un comparador NULL o un modo desconocido devuelve NULL.
+ */
+abb_t* arbol_crear_con_modo(abb_comparador comparador, abb_liberar_elemento destructor, int modo)
 {
     if(!comparador) return NULL;
+    if(modo != ABB_MODO_SIMPLE && modo != ABB_MODO_AVL) return NULL;
     abb_t* arbol = malloc(sizeof(abb_t));
     if(!arbol) return NULL;
     arbol->nodo_raiz = NULL;
     arbol->comparador = comparador;
     arbol->destructor = destructor;
+    arbol->modo = modo;
     return arbol;
 }
 /* 
  * Reserva memoria para un nodo y le asigna el elemento recibido.
+ * Un nodo nuevo es siempre una hoja, de altura 1.
  * Devuelve la direccion de la memoria reservada.
  * Si no pudo reservar la memoria devuelve NULL.
  */
@@ -33,30 +109,139 @@ static nodo_abb_t* nodo_crear(void* elemento)
     nodo_abb_t* nodo = calloc(1, sizeof(nodo_abb_t));
     if(!nodo) return NULL;
     nodo->elemento = elemento;
+    nodo->altura = 1;
     return nodo;
 }
+/*
+ * Devuelve la altura guardada en el nodo, o 0 si el nodo es NULL.
+ * Solo es valida en arboles en modo AVL.
+ */
+static int altura(nodo_abb_t* nodo)
+{
+    return nodo ? nodo->altura : 0;
+}
+/*
+ * Recalcula la altura del nodo a partir de la de sus hijos.
+ */
+static void actualizar_altura(nodo_abb_t* nodo)
+{
+    int altura_izquierda = altura(nodo->izquierda);
+    int altura_derecha = altura(nodo->derecha);
+    nodo->altura = 1 + (altura_izquierda > altura_derecha ? altura_izquierda : altura_derecha);
+}
+/*
+ * Devuelve la diferencia de alturas entre el subarbol izquierdo y el derecho.
+ * Es positiva si el nodo esta cargado a la izquierda.
+ */
+static int factor_balance(nodo_abb_t* nodo)
+{
+    return altura(nodo->izquierda) - altura(nodo->derecha);
+}
+/*
+ * Rota a la derecha el subarbol apuntado por *p_nodo: su hijo izquierdo
+ * pasa a ocupar su lugar.
+
+         *p_nodo            *p_nodo
+            |                  |
+            A                  B
+           / \                / \
+          B   c    ---->     a   A
+         / \                    / \
+        a   b                  b   c
+*/
+static void rotar_derecha(nodo_abb_t** p_nodo)
+{
+    nodo_abb_t* raiz = *p_nodo;
+    nodo_abb_t* nueva_raiz = raiz->izquierda;
+    raiz->izquierda = nueva_raiz->derecha;
+    nueva_raiz->derecha = raiz;
+    actualizar_altura(raiz);
+    actualizar_altura(nueva_raiz);
+    *p_nodo = nueva_raiz;
+}
+/*
+ * Rota a la izquierda el subarbol apuntado por *p_nodo: su hijo derecho
+ * pasa a ocupar su lugar. Es la operacion inversa de rotar_derecha.
+ */
+static void rotar_izquierda(nodo_abb_t** p_nodo)
+{
+    nodo_abb_t* raiz = *p_nodo;
+    nodo_abb_t* nueva_raiz = raiz->derecha;
+    raiz->derecha = nueva_raiz->izquierda;
+    nueva_raiz->izquierda = raiz;
+    actualizar_altura(raiz);
+    actualizar_altura(nueva_raiz);
+    *p_nodo = nueva_raiz;
+}
+/*
+ * Recibe la direccion de un puntero a un nodo cuyos subarboles ya estan
+ * balanceados. Actualiza su altura y, si quedo desbalanceado, lo rota
+ * (rotacion simple o doble) para que vuelva a cumplir la condicion AVL.
+ */
+static void rebalancear(nodo_abb_t** p_nodo)
+{
+    nodo_abb_t* nodo = *p_nodo;
+    actualizar_altura(nodo);
+    int balance = factor_balance(nodo);
+    if(balance > 1)
+    {
+        //cargado a la izquierda. Si el hijo esta cargado a la derecha es rotacion doble
+        if(factor_balance(nodo->izquierda) < 0) rotar_izquierda(&nodo->izquierda);
+        rotar_derecha(p_nodo);
+    }
+    else if(balance < -1)
+    {
+        if(factor_balance(nodo->derecha) > 0) rotar_derecha(&nodo->derecha);
+        rotar_izquierda(p_nodo);
+    }
+}
+/*
+ * Recibe una pila con las direcciones de los punteros que forman un camino
+ * desde la raiz, la vacia y rebalancea cada nodo del camino, desde el mas
+ * profundo hasta la raiz.
+ */
+static void rebalancear_camino(pila_nodos_t* camino)
+{
+    nodo_abb_t** p_nodo;
+    while((p_nodo = pila_desapilar(camino)))
+        if(*p_nodo) rebalancear(p_nodo);
+    pila_liberar(camino);
+}
 /* 
- * Recibe un puntero a puntero al nodo, un comparador, y un elemento.
- * Si *p_nodo es nulo, hago *p_nodo la direccion del nodo nuevo.
- * Si existe *p_nodo, intento insertar a la izquierda o derecha y devuelvo el resultado.
+ * Recibe el arbol, un puntero a puntero al nodo, y un elemento.
+ * Baja desde *p_nodo hasta el puntero nulo donde corresponde el elemento
+ * (a la derecha si es mayor, a la izquierda si no) y ubica ahi el nodo nuevo.
+ * En modo AVL guarda el camino recorrido y rebalancea cada uno de sus nodos.
  * Si recibe un puntero a puntero nulo, o no logra crear un nodo nuevo, devuelve FRACASO.
  */
-int nodo_insertar(abb_comparador comparador, nodo_abb_t** p_nodo, void* elemento)
+int nodo_insertar(abb_t* arbol, nodo_abb_t** p_nodo, void* elemento)
 {   
     if(!p_nodo)  return FRACASO;
-    //si *p_nodo es nulo, ubico el nodo nuevo en *p_nodo.
-    if(!*p_nodo) 
+    bool balancear = (arbol->modo == ABB_MODO_AVL);
+    pila_nodos_t camino;
+    pila_iniciar(&camino);
+    //bajo comparando el elemento del nodo con el nuestro hasta encontrar un lugar vacio
+    while(*p_nodo)
+    {
+        if(balancear && !pila_apilar(&camino, p_nodo))
+        {
+            pila_liberar(&camino);
+            return FRACASO;
+        }
+        if(arbol->comparador(elemento, (*p_nodo)->elemento)>0 )
+            p_nodo = &((*p_nodo)->derecha);
+        else
+            p_nodo = &((*p_nodo)->izquierda);
+    }
+    nodo_abb_t* nodo_auxiliar = nodo_crear(elemento); 
+    if(!nodo_auxiliar)
     {
-        nodo_abb_t* nodo_auxiliar = nodo_crear(elemento); 
-        if(!nodo_auxiliar) return FRACASO;
-        *p_nodo = nodo_auxiliar;
-        return EXITO;
+        pila_liberar(&camino);
+        return FRACASO;
     }
-    //si existe el nodo, comparar su elemento con el nuestro, e insertar en un hijo
-    else if(comparador(elemento, (*p_nodo)->elemento)>0 )
-        return nodo_insertar(comparador,&((*p_nodo)->derecha),elemento);
-    else
-        return nodo_insertar(comparador,&((*p_nodo)->izquierda),elemento);
+    *p_nodo = nodo_auxiliar;
+    rebalancear_camino(&camino);
+    return EXITO;
 }
 /*
  * Recibe un arbol y un elemento.
@@ -66,28 +251,7 @@ int nodo_insertar(abb_comparador comparador, nodo_abb_t** p_nodo, void* elemento
 int arbol_insertar(abb_t* arbol, void* elemento)
 {
     if(!arbol) return FRACASO;
-    return nodo_insertar(arbol->comparador, &(arbol->nodo_raiz), elemento);
-}
-/*
- * Halla el menor nodo de un abb recursivamente.
- */
-nodo_abb_t** rec_minimo_arbol(nodo_abb_t** p_nodo) //p. ej. &(arbol->raiz)
-{
-    //condicion de corte
-    if(!p_nodo||!*p_nodo) return NULL; 
-    //entrar al nodo izquierdo
-    if((*p_nodo)->izquierda) return rec_minimo_arbol(&(*p_nodo)->izquierda);
-    //si no tiene, retorna a si mismo
-    else return p_nodo;
-}
-/*
- *Devuelve la direccion del puntero al nodo heredero del nodo dado (menor de los mayores)
- */
-nodo_abb_t** sucesor(nodo_abb_t** p_nodo_a_borrar)
-{
-    if(!p_nodo_a_borrar||!*p_nodo_a_borrar || !(*p_nodo_a_borrar)->derecha)
-        return NULL;
-    return rec_minimo_arbol(&(*p_nodo_a_borrar)->derecha);
+    return nodo_insertar(arbol, &(arbol->nodo_raiz), elemento);
 }
 //revisa si el puntero derecha del nodo es null.
 bool tiene_hijo_derecho(nodo_abb_t* nodo)
@@ -114,85 +278,87 @@ nodo_abb_t *liberar_nodo_de_un_hijo(nodo_abb_t **nodo)
     return sucesor;
 }
 /*
- * Recibe la direccion p_nodo a un puntero al nodo.
- * Si el nodo tiene dos hijos, escoge un heredero izquierda->derecha para reemplazarlo.
- * Si tiene un solo hijo, conecta este hijo a su abuelo.
- * Si la direccion o su punteros son nulas, devuelve FRACASO y no destruye nada.
+ * Recibe el arbol, la direccion p_nodo de un puntero al nodo desde el cual se busca,
+ * y el elemento a borrar.
+ * Si el nodo con el elemento tiene dos hijos, lo reemplaza su heredero
+ * (el menor de los mayores). Si tiene un solo hijo, conecta este hijo a su abuelo.
+ * En modo AVL guarda el camino hasta el nodo desenganchado y lo rebalancea.
+ * Si no encuentra el elemento devuelve FRACASO y no destruye nada.
  */
-int nodo_destruir_uno(nodo_abb_t** p_nodo_raiz, abb_liberar_elemento destructor)
+static int nodo_borrar(abb_t* arbol, nodo_abb_t** p_nodo, void* elemento)
 {
-    if(p_nodo_raiz==NULL||(*p_nodo_raiz)==NULL) return FRACASO;
-    //destruyo contenido del nodo
-    destructor((*p_nodo_raiz)->elemento);
-    if(tiene_hijo_derecho(*p_nodo_raiz) && tiene_hijo_izquierdo(*p_nodo_raiz)) 
+    bool balancear = (arbol->modo == ABB_MODO_AVL);
+    pila_nodos_t camino;
+    pila_iniciar(&camino);
+    int comparacion;
+    //busco el nodo a borrar
+    while(*p_nodo && (comparacion = arbol->comparador(elemento, (*p_nodo)->elemento)) != 0)
+    {
+        if(balancear && !pila_apilar(&camino, p_nodo))
+        {
+            pila_liberar(&camino);
+            return FRACASO;
+        }
+        p_nodo = (comparacion > 0) ? &(*p_nodo)->derecha : &(*p_nodo)->izquierda;
+    }
+    if(!*p_nodo)
+    {
+        pila_liberar(&camino);
+        return FRACASO;
+    }
+    nodo_abb_t** p_a_desenganchar = p_nodo;
+    if(tiene_hijo_derecho(*p_nodo) && tiene_hijo_izquierdo(*p_nodo))
     {
-        nodo_abb_t** p_heredero = sucesor(p_nodo_raiz);
-        if(!p_heredero || !(*p_heredero)) return FRACASO; 
-        //mudar elemento del heredero
-        (*p_nodo_raiz)->elemento = (*p_heredero)->elemento;
-        //el heredero tiene un hijo derecho o NULL. Quien apunta al heredero ahora apunta a su hijo
-        liberar_nodo_de_un_hijo(p_heredero);
-    } 
-    else liberar_nodo_de_un_hijo(p_nodo_raiz);
+        //busco al heredero: el minimo del subarbol derecho
+        if(balancear && !pila_apilar(&camino, p_nodo))
+        {
+            pila_liberar(&camino);
+            return FRACASO;
+        }
+        p_a_desenganchar = &(*p_nodo)->derecha;
+        while((*p_a_desenganchar)->izquierda)
+        {
+            if(balancear && !pila_apilar(&camino, p_a_desenganchar))
+            {
+                pila_liberar(&camino);
+                return FRACASO;
+            }
+            p_a_desenganchar = &(*p_a_desenganchar)->izquierda;
+        }
+    }
+    //destruyo contenido del nodo
+    if(arbol->destructor) arbol->destructor((*p_nodo)->elemento);
+    //mudar elemento del heredero. El heredero tiene a lo sumo un hijo derecho
+    if(p_a_desenganchar != p_nodo) (*p_nodo)->elemento = (*p_a_desenganchar)->elemento;
+    liberar_nodo_de_un_hijo(p_a_desenganchar);
+    rebalancear_camino(&camino);
     return EXITO;
 }
-/*
- *Recibe la direccion p_nodo a un puntero al nodo desde el cual se comienza a buscar.
- *Busca en un abb el nodo con el elemento dado. 
- *Si lo encuentra devuelve una referencia al puntero (lo cual permite cambiarlo.)
- *Si no lo encuentra devuelvle NULL.
- *Si p_nodo es nula, o *p_nodo es nula, devuelve NULL.
-
-                * -> !elem
-               * *
-              /   \
-             *     * -> !elem
-            * *   *(*) RETURN 
-                     \
-                      * -> elemento
-                     * *
-*/
-nodo_abb_t** nodo_buscar_puntero(nodo_abb_t** p_nodo, void* elemento, abb_comparador comparador)
-{
-    if(!p_nodo || !*p_nodo) return NULL;
-    if(comparador(elemento, (*p_nodo)->elemento )==0) return p_nodo;
-
-    if (comparador(elemento, (*p_nodo)->elemento )>0)
-        return nodo_buscar_puntero(&((*p_nodo)->derecha), elemento, comparador);
-    else 
-        return nodo_buscar_puntero(&((*p_nodo)->izquierda), elemento, comparador);
-}
 
 int arbol_borrar(abb_t* arbol, void* elemento)
 {
     if(!arbol) return FRACASO;
-    //busqueda recursiva del nodo a borrar
-    nodo_abb_t** p_nodo_a_borrar = nodo_buscar_puntero(&(arbol->nodo_raiz), elemento, arbol->comparador);
-    //destruir sin destruir hijos
-    if(!p_nodo_a_borrar) return FRACASO;
-    if(nodo_destruir_uno(p_nodo_a_borrar, arbol->destructor)==FRACASO) return FRACASO;
-    return EXITO;
+    return nodo_borrar(arbol, &(arbol->nodo_raiz), elemento);
 }
 /* 
  * Recibe un nodo raiz, un elemento y un comparador.
  * Si el elemento coincide con el elemento del nodo (su comparador devuelve 0)
- * devuelve el nodo raiz recibido.
- * Si el elemento es 'mayor' al de la raiz, sigue buscando por la derecha.
+ * devuelve ese nodo.
+ * Si el elemento es 'mayor' al del nodo, sigue buscando por la derecha.
  * Si no, sigue buscando por la izquierda.
- * Si recibe una raiz nula, devuelve NULL.
+ * Si llega a una raiz nula, devuelve NULL.
 */
 nodo_abb_t* nodo_buscar(nodo_abb_t* raiz, void* elemento, abb_comparador comparador)
 { 
-    //cond. de corte
-    if(!raiz) return NULL;
-    //elementos coinciden
-    if(comparador(elemento, raiz->elemento )==0) 
-        return raiz;
-    //elementos no coinciden
-    else if (comparador(elemento, raiz->elemento )>0) 
-        return nodo_buscar(raiz->derecha, elemento, comparador);
-    else 
-        return nodo_buscar(raiz->izquierda, elemento, comparador);
+    while(raiz)
+    {
+        int comparacion = comparador(elemento, raiz->elemento);
+        //elementos coinciden
+        if(comparacion == 0) return raiz;
+        //elementos no coinciden
+        raiz = (comparacion > 0) ? raiz->derecha : raiz->izquierda;
+    }
+    return NULL;
 }
 /*
  * Recibe un arbol y un elemento.
@@ -230,103 +396,139 @@ bool arbol_vacio(abb_t* arbol)
     else return false;
 }
 /*
- *Recibe un nodo, un puntero 'array' y su tamanio. 
- *Recorre recursivamente, en inorden, los subarboles del nodo. 
- *Inserta los 'n' elementos del subarbol izquierdo en  la direccion 'array'.
- *Luego el elemento se inserta a si mismo en la direccion array + n.
- *Finalmente inserta los 'm' elementos del subarbol derecho en la direccion 'array + n + 1'.
- *Devuelve n + 1 + m o tamanio_array si se le acaba el espacio.
-
-          array
-            |
-            v
-  -|-|-|-|-|i|i|i|i|i|i|i|i|elem|d|d|d|d|d|d|-|-|-|-|
-
-           |-------n-------|    |-----m-----|
-
-           |------------(RETURN)------------|
-           |-----------(tamanio_array)--------------|
-*/
-int nodo_recorrido_inorden(nodo_abb_t* nodo, void** array, int tamanio_array)
+ * Apila el nodo y sus descendientes izquierdos (la rama por la que empieza un recorrido inorden).
+ */
+static bool apilar_rama_izquierda(pila_nodos_t* pila, nodo_abb_t* nodo)
 {
-    if(!nodo|| tamanio_array <=0) return 0;
-    int insertados = 0;
-    //recursion por la izquierda
-    if (nodo->izquierda)
-        insertados += nodo_recorrido_inorden(nodo->izquierda, array + insertados, tamanio_array - insertados);
-    if(tamanio_array <= insertados) return insertados;
-    //insercion si me queda espacio
-    array[insertados] = nodo->elemento;
-    insertados++;
-    //recursion por la derecha
-    if (nodo->derecha)
-        insertados += nodo_recorrido_inorden(nodo->derecha, array + insertados, tamanio_array - insertados);
-    return insertados;
+    for(; nodo; nodo = nodo->izquierda)
+        if(!pila_apilar(pila, nodo)) return false;
+    return true;
 }
 /*
- *Recibe un nodo, un puntero 'array' y su tamanio. 
- *Recorre recursivamente, en preorden, los subarboles del nodo. 
- *El elemento se inserta a si mismo en la direccion array.
- *Inserta los 'n' elementos del subarbol izquierdo en  la direccion 'array + 1'.
- *Finalmente inserta los 'm' elementos del subarbol derecho en la direccion 'array + 1 + n'.
- *Devuelve 1 + n + m o tamanio_array si se le acaba el espacio.
-
-          array
-            |
-            v
-  -|-|-|-|-|elem|i|i|i|i|i|i|i|i|d|d|d|d|d|d|-|-|-|-|
-
-                |-------n-------|-----m-----|
+ * Apila el nodo y baja hasta una hoja prefiriendo siempre el hijo izquierdo
+ * (el camino hasta el primer nodo de un recorrido postorden).
+ */
+static bool apilar_camino_a_hoja(pila_nodos_t* pila, nodo_abb_t* nodo)
+{
+    while(nodo)
+    {
+        if(!pila_apilar(pila, nodo)) return false;
+        nodo = nodo->izquierda ? nodo->izquierda : nodo->derecha;
+    }
+    return true;
+}
+/*
+ * Prepara un iterador para recorrer los nodos a partir de raiz.
+ * Devuelve false si el recorrido no es valido o no pudo reservar memoria.
+ */
+static bool iterador_iniciar(struct abb_iterador* iterador, nodo_abb_t* raiz, int recorrido)
+{
+    iterador->recorrido = recorrido;
+    pila_iniciar(&iterador->pila);
+    bool apilado;
+    switch(recorrido)
+    {
+        case ABB_RECORRER_INORDEN:
+            apilado = apilar_rama_izquierda(&iterador->pila, raiz);
+            break;
+        case ABB_RECORRER_PREORDEN:
+            apilado = !raiz || pila_apilar(&iterador->pila, raiz);
+            break;
+        case ABB_RECORRER_POSTORDEN:
+            apilado = apilar_camino_a_hoja(&iterador->pila, raiz);
+            break;
+        default:
+            apilado = false;
+    }
+    if(!apilado) pila_liberar(&iterador->pila);
+    return apilado;
+}
+/*
+ * Devuelve el proximo nodo del recorrido, o NULL si no quedan nodos.
+ * Cada nodo se apila y desapila una sola vez, asi que recorrer el arbol entero es O(n).
+ * Si la pila no puede crecer el recorrido termina antes de tiempo.
 
-           |------------(RETURN)------------|
-           |-----------(tamanio_array)--------------|
+   inorden:   desapilo N, apilo la rama izquierda de N->derecha.
+   preorden:  desapilo N, apilo N->derecha y luego N->izquierda.
+   postorden: desapilo N; si era hijo izquierdo de P (el nuevo tope)
+              y P tiene hijo derecho, apilo el camino a hoja de P->derecha.
 */
-int nodo_recorrido_preorden(nodo_abb_t* nodo, void** array, int tamanio_array)
-{
-    int insertados =0;
-    //insercion
-    array[insertados] = nodo->elemento; 
-    insertados++;
-    //recursion por la izquierda
-    if(nodo->izquierda) insertados += nodo_recorrido_preorden(nodo->izquierda, array+insertados, tamanio_array-insertados);
-    //recursion por la derecha
-    if(nodo->derecha) insertados += nodo_recorrido_preorden(nodo->derecha, array+insertados, tamanio_array-insertados);
-    return insertados;
+static nodo_abb_t* iterador_siguiente_nodo(struct abb_iterador* iterador)
+{
+    nodo_abb_t* nodo = pila_desapilar(&iterador->pila);
+    if(!nodo) return NULL;
+    bool apilado = true;
+    switch(iterador->recorrido)
+    {
+        case ABB_RECORRER_INORDEN:
+            apilado = apilar_rama_izquierda(&iterador->pila, nodo->derecha);
+            break;
+        case ABB_RECORRER_PREORDEN:
+            if(nodo->derecha) apilado = pila_apilar(&iterador->pila, nodo->derecha);
+            if(apilado && nodo->izquierda) apilado = pila_apilar(&iterador->pila, nodo->izquierda);
+            break;
+        case ABB_RECORRER_POSTORDEN:
+        {
+            nodo_abb_t* padre = pila_tope(&iterador->pila);
+            if(padre && padre->izquierda == nodo && padre->derecha)
+                apilado = apilar_camino_a_hoja(&iterador->pila, padre->derecha);
+            break;
+        }
+    }
+    if(!apilado) pila_liberar(&iterador->pila);
+    return nodo;
+}
+/*
+ * Recalcula, en postorden, la altura de cada nodo del subarbol.
+ */
+static void nodo_recalcular_alturas(nodo_abb_t* nodo)
+{
+    struct abb_iterador iterador;
+    if(!iterador_iniciar(&iterador, nodo, ABB_RECORRER_POSTORDEN)) return;
+    while((nodo = iterador_siguiente_nodo(&iterador)))
+        actualizar_altura(nodo);
+    pila_liberar(&iterador.pila);
 }
-/*         
- * Recibe un nodo, un puntero 'array' y su tamanio. 
- * Recorre recursivamente, en postorden, los subarboles del nodo. 
- * Inserta los 'n' elementos del subarbol izquierdo en  la direccion 'array'.
- * Inserta los 'm' elementos del subarbol derecho en la direccion 'array + n'.
- * Finalmente el elemento se inserta a si mismo en la direccion 'array + n + m'.
- * Devuelve n + m + 1 o tamanio_array si se le acaba el espacio.
+/*
+ * Recibe un arbol y un modo.
+ * Cambia el modo del arbol. Si el modo nuevo es AVL recalcula las alturas,
+ * que en modo simple no se mantienen. No modifica la forma del arbol.
+ * Si el arbol es nulo o el modo es desconocido devuelve FRACASO.
+ */
+int arbol_cambiar_modo(abb_t* arbol, int modo)
+{
+    if(!arbol) return FRACASO;
+    if(modo != ABB_MODO_SIMPLE && modo != ABB_MODO_AVL) return FRACASO;
+    if(modo == ABB_MODO_AVL && arbol->modo != ABB_MODO_AVL)
+        nodo_recalcular_alturas(arbol->nodo_raiz);
+    arbol->modo = modo;
+    return EXITO;
+}
+/*
+ * Recibe un nodo, un recorrido, un puntero 'array' y su tamanio. 
+ * Recorre el subarbol del nodo en el orden pedido e inserta cada elemento
+ * en la siguiente posicion libre del array.
+ * Devuelve la cantidad de elementos insertados, que es a lo sumo tamanio_array.
 
           array
             |
             v
-  -|-|-|-|-|i|i|i|i|i|i|i|i|d|d|d|d|d|d|elem|-|-|-|-|
-
-           |-------n-------|-----m-----|
+  -|-|-|-|-|1|2|3|4|5|6|7|8|9|-|-|-|-|-|-|-|-|-|-|
 
-           |------------(RETURN)------------|
+           |-----(RETURN)----|
            |-----------(tamanio_array)--------------|
 */
-int nodo_recorrido_postorden(nodo_abb_t* nodo, void** array, int tamanio_array)
-{
-    if(!nodo|| tamanio_array <=0) return 0;
-    int insertados =0;
-    //recursion por la izquierda
-    if(nodo->izquierda) 
-        insertados += nodo_recorrido_postorden(nodo->izquierda, array+insertados, tamanio_array-insertados);
-    //recursion por la derecha
-    if(nodo->derecha) 
-        insertados += nodo_recorrido_postorden(nodo->derecha, array+insertados, tamanio_array-insertados);
-    //insercion si me queda espacio
-    if(tamanio_array > insertados)
+static int nodo_recorrido(nodo_abb_t* nodo, int recorrido, void** array, int tamanio_array)
+{
+    struct abb_iterador iterador;
+    if(!iterador_iniciar(&iterador, nodo, recorrido)) return 0;
+    int insertados = 0;
+    while(insertados < tamanio_array && (nodo = iterador_siguiente_nodo(&iterador)))
     {
         array[insertados] = nodo->elemento;
         insertados++;
-    } 
+    }
+    pila_liberar(&iterador.pila);
     return insertados;
 }
 /*
@@ -338,7 +540,7 @@ int nodo_recorrido_postorden(nodo_abb_t* nodo, void** array, int tamanio_array)
 int arbol_recorrido_inorden(abb_t* arbol, void** array, int tamanio_array)
 {
     if( !arbol || !(arbol->nodo_raiz) || !array || tamanio_array<=0 ) return 0;
-    return nodo_recorrido_inorden(arbol->nodo_raiz, array, tamanio_array);
+    return nodo_recorrido(arbol->nodo_raiz, ABB_RECORRER_INORDEN, array, tamanio_array);
 }
 /*
  * Recibe un arbol, un array y su tamanio.
@@ -349,7 +551,7 @@ int arbol_recorrido_inorden(abb_t* arbol, void** array, int tamanio_array)
 int arbol_recorrido_preorden(abb_t* arbol, void** array, int tamanio_array)
 {
     if( !arbol || !(arbol->nodo_raiz) || !array || tamanio_array<=0 ) return 0;
-    return nodo_recorrido_preorden(arbol->nodo_raiz, array, tamanio_array);
+    return nodo_recorrido(arbol->nodo_raiz, ABB_RECORRER_PREORDEN, array, tamanio_array);
 }
 /*
  * Recibe un arbol, un array y su tamanio.
@@ -360,21 +562,43 @@ int arbol_recorrido_preorden(abb_t* arbol, void** array, int tamanio_array)
 int arbol_recorrido_postorden(abb_t* arbol, void** array, int tamanio_array)
 {
     if( !arbol || !(arbol->nodo_raiz) || !array || tamanio_array<=0 ) return 0;
-    return nodo_recorrido_postorden(arbol->nodo_raiz, array, tamanio_array);
+    return nodo_recorrido(arbol->nodo_raiz, ABB_RECORRER_POSTORDEN, array, tamanio_array);
 }
 /*
  * Recibe la direccion p_nodo a un puntero al nodo.
- * Destruye a un nodo y sus subarboles con destructor.
- * Si la direccion o su punteros son nulas, devuelve NULL y no destruye nada.
- */
+ * Destruye a un nodo y sus subarboles con destructor, sin recursion ni pila:
+ * mientras el nodo actual tenga hijo izquierdo lo rota a la derecha, y cuando
+ * no lo tiene lo libera y sigue por su hijo derecho.
+ * Si la direccion o su punteros son nulas, devuelve FRACASO y no destruye nada.
+
+        N            I
+       / \          / \
+      I   d  --->  a   N      (rotacion)
+     / \              / \
+    a   b            b   d
+*/
 int nodo_destruir(nodo_abb_t** p_nodo, abb_liberar_elemento destructor)
 {
     if(p_nodo==NULL) return FRACASO;
     else if ((*p_nodo)==NULL) return FRACASO;
-    if((*p_nodo)->izquierda) nodo_destruir(&(*p_nodo)->izquierda, destructor);
-    if((*p_nodo)->derecha) nodo_destruir(&(*p_nodo)->derecha, destructor);
-    if(destructor) destructor((*p_nodo)->elemento);
-    free(*p_nodo);
+    nodo_abb_t* actual = *p_nodo;
+    while(actual)
+    {
+        if(actual->izquierda)
+        {
+            nodo_abb_t* izquierdo = actual->izquierda;
+            actual->izquierda = izquierdo->derecha;
+            izquierdo->derecha = actual;
+            actual = izquierdo;
+        }
+        else
+        {
+            nodo_abb_t* derecho = actual->derecha;
+            if(destructor) destructor(actual->elemento);
+            free(actual);
+            actual = derecho;
+        }
+    }
     *p_nodo = NULL;
     return EXITO;
 }
@@ -388,61 +612,28 @@ void arbol_destruir(abb_t* arbol)
     free(arbol);
 }
 /* 
- * Recibe un nodo no nulo, un puntero a funcion y una variable extra. 
- * Recorre recursivamente, en inorden, los subarboles del nodo. 
- * En cada nodo, ejecuta la funcion con el elemento del nodo y el extra.
- * Detiene la operacion si funcion devuelve true, y devuelve INTERRUPCION.
- * Si termina el arbol sin que la funcion devuelva true, devuelve EXITO.
-*/
-int rec_iterador_inorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
-{
-    //recursion por la izquierda
-    if (nodo->izquierda)
-        if(rec_iterador_inorden(nodo->izquierda, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    //llamada a funcion
-    if(funcion(nodo->elemento, extra)) return INTERRUPCION;
-    //recursion por la derecha
-    if (nodo->derecha)
-        if(rec_iterador_inorden(nodo->derecha, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    return EXITO;
-}
-/* 
- * Recibe un nodo no nulo, un puntero a funcion y una variable extra. 
- * Recorre recursivamente, en preorden, los subarboles del nodo. 
+ * Recibe un nodo no nulo, un recorrido, un puntero a funcion y una variable extra. 
+ * Recorre los subarboles del nodo en el orden pedido. 
  * En cada nodo, ejecuta la funcion con el elemento del nodo y el extra.
  * Detiene la operacion si funcion devuelve true, y devuelve INTERRUPCION.
  * Si termina el arbol sin que la funcion devuelva true, devuelve EXITO.
+ * Si no puede recorrer (recorrido invalido o sin memoria) devuelve FRACASO.
 */
-int rec_iterador_preorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
-{
-    //llamada a funcion
-    if(funcion(nodo->elemento, extra)) return INTERRUPCION;
-    //recursion por la izquierda
-    if (nodo->izquierda)
-        if(rec_iterador_preorden(nodo->izquierda, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    //recursion por la derecha
-    if (nodo->derecha)
-        if(rec_iterador_preorden(nodo->derecha, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    return EXITO;
-}
-/* 
- * Recibe un nodo no nulo, un puntero a funcion y una variable extra. 
- * Recorre recursivamente, en postorden, los subarboles del nodo. 
- * En cada nodo, ejecuta la funcion con el elemento del nodo y el extra.
- * Detiene la operacion si funcion devuelve true, y devuelve INTERRUPCION.
- * Si termina el arbol sin que la funcion devuelva true, devuelve EXITO.
-*/
-int rec_iterador_postorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
-{
-    //recursion por la izquierda
-    if (nodo->izquierda)
-        if(rec_iterador_postorden(nodo->izquierda, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    //recursion por la derecha
-    if (nodo->derecha)
-        if(rec_iterador_postorden(nodo->derecha, funcion, extra)==INTERRUPCION) return INTERRUPCION;
-    //llamada a funcion
-    if(funcion(nodo->elemento, extra)) return INTERRUPCION;
-    return EXITO;
+static int nodo_con_cada_elemento(nodo_abb_t* nodo, int recorrido, bool (*funcion)(void*, void*), void* extra)
+{
+    struct abb_iterador iterador;
+    if(!iterador_iniciar(&iterador, nodo, recorrido)) return FRACASO;
+    int resultado = EXITO;
+    while((nodo = iterador_siguiente_nodo(&iterador)))
+    {
+        if(funcion(nodo->elemento, extra))
+        {
+            resultado = INTERRUPCION;
+            break;
+        }
+    }
+    pila_liberar(&iterador.pila);
+    return resultado;
 }
 /*
  * Recibe un arbol, una funcion de dos parametros, un parametro extra, y una variable 'recorrido'.
@@ -454,16 +645,49 @@ int rec_iterador_postorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void
 void abb_con_cada_elemento(abb_t* arbol, int recorrido, bool (*funcion)(void*, void*), void* extra)
 {
     if(!arbol || !(arbol->nodo_raiz) || !funcion) return;
-    switch(recorrido)
+    nodo_con_cada_elemento(arbol->nodo_raiz, recorrido, funcion, extra);
+}
+/*
+ * Recibe un arbol y un recorrido valido.
+ * Reserva un iterador externo posicionado antes del primer elemento.
+ * Devuelve NULL si el arbol es nulo, el recorrido invalido o falta memoria.
+ */
+abb_iterador_t* abb_iterador_crear(abb_t* arbol, int recorrido)
+{
+    if(!arbol) return NULL;
+    abb_iterador_t* iterador = malloc(sizeof(abb_iterador_t));
+    if(!iterador) return NULL;
+    if(!iterador_iniciar(iterador, arbol->nodo_raiz, recorrido))
     {
-        case ABB_RECORRER_INORDEN: 
-            rec_iterador_inorden(arbol->nodo_raiz,funcion, extra);
-            break;
-        case ABB_RECORRER_PREORDEN: 
-            rec_iterador_preorden(arbol->nodo_raiz,funcion, extra); 
-            break;
-        case ABB_RECORRER_POSTORDEN: 
-            rec_iterador_postorden(arbol->nodo_raiz,funcion, extra);
-            break;
+        free(iterador);
+        return NULL;
     }
-}
\ No newline at end of file
+    return iterador;
+}
+/*
+ * Devuelve true si al iterador le quedan elementos por devolver.
+ */
+bool abb_iterador_tiene_siguiente(abb_iterador_t* iterador)
+{
+    if(!iterador) return false;
+    return iterador->pila.tope > 0;
+}
+/*
+ * Avanza el iterador y devuelve el elemento del nodo que visita.
+ * Devuelve NULL si no quedan elementos o el iterador es nulo.
+ */
+void* abb_iterador_siguiente(abb_iterador_t* iterador)
+{
+    if(!iterador) return NULL;
+    nodo_abb_t* nodo = iterador_siguiente_nodo(iterador);
+    return nodo ? nodo->elemento : NULL;
+}
+/*
+ * Libera el iterador y la pila que pudiera tener en memoria dinamica.
+ */
+void abb_iterador_destruir(abb_iterador_t* iterador)
+{
+    if(!iterador) return;
+    pila_liberar(&iterador->pila);
+    free(iterador);
+}
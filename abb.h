@@ -5,6 +5,9 @@
 #define ABB_RECORRER_PREORDEN  1
 #define ABB_RECORRER_POSTORDEN 2
 
+#define ABB_MODO_SIMPLE 0
+#define ABB_MODO_AVL    1
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -27,14 +30,18 @@ typedef struct nodo_abb {
 	void* elemento;
 	struct nodo_abb* izquierda;
 	struct nodo_abb* derecha;
+	int altura;
 } nodo_abb_t;
 
 typedef struct abb{
 	nodo_abb_t* nodo_raiz;
 	abb_comparador comparador;
 	abb_liberar_elemento destructor;
+	int modo;
 } abb_t;
 
+typedef struct abb_iterador abb_iterador_t;
+
 /*
  * Crea el arbol y reserva la memoria necesaria de la estructura.
  * Comparador se utiliza para comparar dos elementos.
@@ -45,6 +52,28 @@ typedef struct abb{
  */
 abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor);
 
+/*
+ * Igual que arbol_crear, pero permite elegir el modo del arbol.
+ * ABB_MODO_SIMPLE es el abb de siempre (el que crea arbol_crear).
+ * ABB_MODO_AVL rebalancea el arbol en cada insercion y borrado, de
+ * forma que su altura (y el costo de insertar, buscar y borrar) es
+ * O(log n) aun si los elementos llegan ordenados.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error.
+ */
+abb_t* arbol_crear_con_modo(abb_comparador comparador, abb_liberar_elemento destructor, int modo);
+
+/*
+ * Cambia el modo de un arbol existente sin alterar su forma.
+ * Al pasar a ABB_MODO_AVL se recalculan las alturas de todos los
+ * nodos; las inserciones y borrados siguientes mantienen el balance.
+ * Sirve para reconstruir un arbol con una forma dada (insertando en
+ * ABB_MODO_SIMPLE) y luego seguir usandolo balanceado.
+ *
+ * Devuelve 0 si pudo cambiar el modo o -1 si no pudo.
+ */
+int arbol_cambiar_modo(abb_t* arbol, int modo);
+
 /*
  * Inserta un elemento en el arbol.
  * Devuelve 0 si pudo insertar o -1 si no pudo.
@@ -130,4 +159,32 @@ void arbol_destruir(abb_t* arbol);
 */
 void abb_con_cada_elemento(abb_t* arbol, int recorrido, bool (*funcion)(void*, void*), void* extra);
 
+/*
+ * Crea un iterador externo que recorre el arbol en el orden pedido
+ * (ABB_RECORRER_INORDEN, ABB_RECORRER_PREORDEN o
+ * ABB_RECORRER_POSTORDEN). A diferencia de abb_con_cada_elemento, el
+ * recorrido puede pausarse entre llamadas. El iterador es valido hasta
+ * que se modifique el arbol (insertando o borrando elementos).
+ *
+ * Devuelve el puntero al iterador creado o NULL en caso de error.
+ */
+abb_iterador_t* abb_iterador_crear(abb_t* arbol, int recorrido);
+
+/*
+ * Devuelve true si hay mas elementos sobre los cuales iterar o false
+ * si no hay mas.
+ */
+bool abb_iterador_tiene_siguiente(abb_iterador_t* iterador);
+
+/*
+ * Devuelve el próximo elemento del recorrido.
+ * En caso de error o si no quedan elementos devuelve NULL.
+ */
+void* abb_iterador_siguiente(abb_iterador_t* iterador);
+
+/*
+ * Libera la memoria reservada por el iterador.
+ */
+void abb_iterador_destruir(abb_iterador_t* iterador);
+
 #endif /* __ARBOL_BINARIO_DE_BUSQUEDA_H__ */
@@ -46,7 +46,8 @@ pokedex_t* pokedex_crear(char entrenador[MAX_NOMBRE]){
     strcpy(pokedex->nombre_entrenador, entrenador);
     pokedex->ultimos_capturados = lista_crear();
     pokedex->ultimos_vistos = lista_crear();
-    pokedex->pokemones = arbol_crear(comparador_especie_pokemon,destructor_especie_pokemon);
+    //los avistamientos suelen llegar ordenados por numero, un abb simple degeneraria en lista
+    pokedex->pokemones = arbol_crear_con_modo(comparador_especie_pokemon,destructor_especie_pokemon, ABB_MODO_AVL);
     return pokedex;
 }
 /*
@@ -498,6 +499,8 @@ pokedex_t* pokedex_prender()
     }
     fscanf(archivo,"%[^\n]\n", nombre);
     pokedex_t* pokedex = pokedex_crear(nombre);
+    //las especies vienen en preorden: insertarlas sin rebalancear reconstruye la forma guardada
+    arbol_cambiar_modo(pokedex->pokemones, ABB_MODO_SIMPLE);
     scan_t scan;
     scan.error = false;
     int resultado = EXITO;
@@ -507,6 +510,7 @@ pokedex_t* pokedex_prender()
         if(scan.tipo == 'P') resultado = lista_insertar(scan.especie->pokemones, scan.pokemon);
         leer_linea(archivo, &scan);
     }
+    arbol_cambiar_modo(pokedex->pokemones, ABB_MODO_AVL);
     fclose(archivo);
     return pokedex;
 }